@@ -4,6 +4,7 @@
 #include <chrono> // For benchmarking
 #include <algorithm>
 #include "../src/shared_memory_access.hpp"
+#include "../src/autotune.hpp"
 
 
 using SharedMemoryAccess::Fields::c; //concentration
@@ -35,41 +36,55 @@ inline void apply_boundary_conditions(){
     }
 }
 
-inline void perform_diffusion(){
-    #pragma omp parallel for num_threads(4)
-    for (int i = 1; i < Rows - 1; ++i) {
-        for (int j = 1; j < Cols - 1; ++j) {
-            temp[i][j] = c[i][j] + dt * (
-                c[i-1][j] + c[i+1][j] +
-                c[i][j - 1] + c[i][j + 1] 
-                - 4 * c[i][j]
-            );
-        }
-    }
+inline void perform_diffusion(const Autotune::Config& config){
+    Autotune::parallel_for_tiles(config, 1, Rows - 1, 1, Cols - 1, [](int i, int j) {
+        temp[i][j] = c[i][j] + dt * (
+            c[i-1][j] + c[i+1][j] +
+            c[i][j - 1] + c[i][j + 1] 
+            - 4 * c[i][j]
+        );
+    });
     std::memcpy(c, temp, sizeof(c));
 }
 
+inline void step(const Autotune::Config& config){
+    perform_diffusion(config);
+    apply_boundary_conditions();
+    timestep = timestep + dt;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    const bool autotune = argc >= 2 && std::strcmp(argv[1], "--autotune") == 0;
+    if (argc != 2 && !(autotune && argc == 3)) {
         std::cerr << "Usage: " << argv[0] << " <number of iterations>" << std::endl;
+        std::cerr << "       " << argv[0] << " --autotune [steps per candidate]" << std::endl;
         return 1;
     }
 
-    int iterations = std::atoi(argv[1]);
+    int iterations = autotune ? (argc == 3 ? std::atoi(argv[2]) : Autotune::DefaultSteps) : std::atoi(argv[1]);
     if (iterations <= 0) {
         std::cerr << "Number of iterations must be a positive integer." << std::endl;
         return 1;
     }
 
     try {
-        
+        // Default: 4 threads, one band of interior rows each
+        const Autotune::Config defaults = Autotune::row_bands(4, Rows - 2, Cols - 2);
+
+        if (autotune) {
+            auto config = Autotune::tune("diffusion", Rows - 2, Cols - 2, defaults, iterations, step);
+            std::cout << "Tuned: threads=" << config.threads
+                      << " tile=" << config.tile_rows << "x" << config.tile_cols << std::endl;
+            return 0;
+        }
+
+        const Autotune::Config config = Autotune::load("diffusion", defaults);
+
         // Benchmark the code
         auto start_time = std::chrono::high_resolution_clock::now();
 
         for (int iter = 0; iter < iterations; ++iter){
-            perform_diffusion();
-            apply_boundary_conditions();
-            timestep = timestep + dt;
+            step(config);
         }
 
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -1,4 +1,5 @@
 #%%
+import hashlib
 import json
 from pathlib import Path
 import numpy as np
@@ -174,6 +175,17 @@ class SharedMemoryAllocator:
         }
         return mapping.get(dtype, None)
 
+    def layout_hash(self) -> str:
+        """
+        Short digest of names, types, shapes and offsets of all fields.
+        Used by the C++ side to key per-layout data such as autotuning results.
+        """
+        desc = [
+            [item["name"], str(item["dtype"]), [int(x) for x in item["shape"]], int(item["offset"])]
+            for item in self.layout_info
+        ]
+        return hashlib.sha1(json.dumps(desc).encode("utf-8")).hexdigest()[:16]
+
     def generate_cpp_header(self, output_file: str = "shared_memory_layout"):
         """
         Generates a C++ header that defines compile-time offsets for each field
@@ -188,6 +200,7 @@ class SharedMemoryAllocator:
         spec = json.loads(Path(self.spec_file).read_text())
         lines.append(f'inline constexpr const char* SHM_NAME = "{spec["shm_name"]}";')
         lines.append(f'inline constexpr std::size_t SHM_SIZE = {self.total_size};' + "// Bytes")
+        lines.append(f'inline constexpr const char* SHM_LAYOUT_HASH = "{self.layout_hash()}";')
         lines.append("")
         lines.append("namespace SharedMemoryLayout {")
         lines.append("")
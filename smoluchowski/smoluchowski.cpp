@@ -2,6 +2,7 @@
 #include <cstdlib> // For std::atoi
 #include <chrono>  // For benchmarking
 #include "../src/shared_memory_access.hpp"
+#include "../src/autotune.hpp"
 
 //Exposing Shared Memory fields
 using SharedMemoryAccess::Fields::c;
@@ -40,84 +41,99 @@ inline void apply_boundary_conditions(){
     }
 }
 
-void drift_diffusion() {
+void drift_diffusion(const Autotune::Config& config) {
     //using T = typename std::remove_all_extents<ArrayType>::type; // Deduce scalar type (e.g., float);
-    #pragma omp parallel for num_threads(4)
-    for (int i = 1; i < Rows - 1; ++i) {
-        for (int j = 1; j < Cols - 1; ++j) {
-            // Extract neighboring concentrations
-            auto c_P = c[i][j];     // Current cell
-            auto c_E = c[i+1][j]; // East neighbor
-            auto c_W = c[i-1][j]; // West neighbor
-            auto c_N = c[i][j+1]; // North neighbor
-            auto c_S = c[i][j-1]; // South neighbor
-
-            // Concentration gradients
-            auto grad_c_e = c_E - c_P;
-            auto grad_c_w = c_P - c_W;
-            auto grad_c_n = c_N - c_P;
-            auto grad_c_s = c_P - c_S;
-
-            // Diffusion fluxes due to potential gradient
-            auto J_dif_e = -D_x[i][j] * grad_c_e;
-            auto J_dif_w = -D_x[i-1][j] * grad_c_w;
-            auto J_dif_n = -D_y[i][j] * grad_c_n;
-            auto J_dif_s = -D_y[i][j-1] * grad_c_s;
-
-            // Alpha coefficients for upwind scheme
-            auto alpha_e = alpha_x[i][j];
-            auto alpha_w = 1.0f - alpha_x[i-1][j];
-            auto alpha_n = alpha_y[i][j];
-            auto alpha_s = 1.0f - alpha_y[i][j-1];
-
-            // Concentrations at faces with upwind correction
-            auto c_e = c_E * alpha_e + c_P * (1.0f - alpha_e);
-            auto c_w = c_W * alpha_w + c_P * (1.0f - alpha_w);
-            auto c_n = c_N * alpha_n + c_P * (1.0f - alpha_n);
-            auto c_s = c_S * alpha_s + c_P * (1.0f - alpha_s);
-
-            // Advection fluxes due to potential gradient
-            auto J_adv_e = -D_x[i][j] * dU_x[i][j] * c_e;
-            auto J_adv_w = -D_x[i-1][j] * dU_x[i-1][j] * c_w;
-            auto J_adv_n = -D_y[i][j] * dU_y[i][j] * c_n;
-            auto J_adv_s = -D_y[i][j-1] * dU_y[i][j-1] * c_s;
-
-            // Total fluxes at cell faces
-            auto J_E = J_dif_e + J_adv_e;
-            auto J_W = J_dif_w + J_adv_w;
-            auto J_N = J_dif_n + J_adv_n;
-            auto J_S = J_dif_s + J_adv_s;
-
-            auto J_tot = -J_E + J_W - lambda_n[j] * J_N + lambda_s[j] * J_S;
-
-            div_J[i][j] = -J_tot;       // Update divergence of flux
-            c_next[i][j] = c_P + J_tot * dt; // Update concentration
-        }
-    }
+    Autotune::parallel_for_tiles(config, 1, Rows - 1, 1, Cols - 1, [](int i, int j) {
+        // Extract neighboring concentrations
+        auto c_P = c[i][j];     // Current cell
+        auto c_E = c[i+1][j]; // East neighbor
+        auto c_W = c[i-1][j]; // West neighbor
+        auto c_N = c[i][j+1]; // North neighbor
+        auto c_S = c[i][j-1]; // South neighbor
+
+        // Concentration gradients
+        auto grad_c_e = c_E - c_P;
+        auto grad_c_w = c_P - c_W;
+        auto grad_c_n = c_N - c_P;
+        auto grad_c_s = c_P - c_S;
+
+        // Diffusion fluxes due to potential gradient
+        auto J_dif_e = -D_x[i][j] * grad_c_e;
+        auto J_dif_w = -D_x[i-1][j] * grad_c_w;
+        auto J_dif_n = -D_y[i][j] * grad_c_n;
+        auto J_dif_s = -D_y[i][j-1] * grad_c_s;
+
+        // Alpha coefficients for upwind scheme
+        auto alpha_e = alpha_x[i][j];
+        auto alpha_w = 1.0f - alpha_x[i-1][j];
+        auto alpha_n = alpha_y[i][j];
+        auto alpha_s = 1.0f - alpha_y[i][j-1];
+
+        // Concentrations at faces with upwind correction
+        auto c_e = c_E * alpha_e + c_P * (1.0f - alpha_e);
+        auto c_w = c_W * alpha_w + c_P * (1.0f - alpha_w);
+        auto c_n = c_N * alpha_n + c_P * (1.0f - alpha_n);
+        auto c_s = c_S * alpha_s + c_P * (1.0f - alpha_s);
+
+        // Advection fluxes due to potential gradient
+        auto J_adv_e = -D_x[i][j] * dU_x[i][j] * c_e;
+        auto J_adv_w = -D_x[i-1][j] * dU_x[i-1][j] * c_w;
+        auto J_adv_n = -D_y[i][j] * dU_y[i][j] * c_n;
+        auto J_adv_s = -D_y[i][j-1] * dU_y[i][j-1] * c_s;
+
+        // Total fluxes at cell faces
+        auto J_E = J_dif_e + J_adv_e;
+        auto J_W = J_dif_w + J_adv_w;
+        auto J_N = J_dif_n + J_adv_n;
+        auto J_S = J_dif_s + J_adv_s;
+
+        auto J_tot = -J_E + J_W - lambda_n[j] * J_N + lambda_s[j] * J_S;
+
+        div_J[i][j] = -J_tot;       // Update divergence of flux
+        c_next[i][j] = c_P + J_tot * dt; // Update concentration
+    });
 }
 
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    const bool autotune = argc >= 2 && std::strcmp(argv[1], "--autotune") == 0;
+    if (argc != 2 && !(autotune && argc == 3)) {
         std::cerr << "Usage: " << argv[0] << " <number of iterations>" << std::endl;
+        std::cerr << "       " << argv[0] << " --autotune [steps per candidate]" << std::endl;
         return 1;
     }
 
-    int iterations = std::atoi(argv[1]);
+    int iterations = autotune ? (argc == 3 ? std::atoi(argv[2]) : Autotune::DefaultSteps) : std::atoi(argv[1]);
     if (iterations <= 0) {
         std::cerr << "Number of iterations must be a positive integer." << std::endl;
         return 1;
     }
 
     try {
-        // Benchmark the diffusion process
-        auto start_time = std::chrono::high_resolution_clock::now();
+        // Default: 4 threads, one band of interior rows each
+        const Autotune::Config defaults = Autotune::row_bands(4, Rows - 2, Cols - 2);
 
-         for (int iter = 0; iter < iterations; ++iter){
-            drift_diffusion();
+        auto step = [iterations](const Autotune::Config& config) {
+            drift_diffusion(config);
             apply_boundary_conditions();
             std::swap(c, c_next);
             timestep = timestep+dt*iterations;
+        };
+
+        if (autotune) {
+            auto config = Autotune::tune("smoluchowski", Rows - 2, Cols - 2, defaults, iterations, step);
+            std::cout << "Tuned: threads=" << config.threads
+                      << " tile=" << config.tile_rows << "x" << config.tile_cols << std::endl;
+            return 0;
+        }
+
+        const Autotune::Config config = Autotune::load("smoluchowski", defaults);
+
+        // Benchmark the diffusion process
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+         for (int iter = 0; iter < iterations; ++iter){
+            step(config);
         }
 
         auto end_time = std::chrono::high_resolution_clock::now();
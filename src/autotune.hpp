@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/utsname.h>
+
+#include "shared_memory_access.hpp"
+
+
+
+namespace Autotune {
+
+    // Number of timed steps per candidate when no count is given on the command line
+    inline constexpr int DefaultSteps = 200;
+
+    // Timed runs per candidate; the fastest run counts
+    inline constexpr int Repeats = 3;
+
+    // Relative speedup a candidate needs over the default to replace it
+    inline constexpr double Margin = 0.05;
+
+    // Execution parameters of a stencil kernel
+    struct Config {
+        int threads;    // OpenMP thread count
+        int tile_rows;  // rows per tile
+        int tile_cols;  // columns per tile
+    };
+
+    // Run body(i, j) over [i_begin, i_end) x [j_begin, j_end), split into tiles shared among threads
+    template <typename Body>
+    inline void parallel_for_tiles(const Config& config, int i_begin, int i_end, int j_begin, int j_end, Body&& body) {
+        const int tile_rows = config.tile_rows;
+        const int tile_cols = config.tile_cols;
+        #pragma omp parallel for collapse(2) schedule(static) num_threads(config.threads)
+        for (int ii = i_begin; ii < i_end; ii += tile_rows) {
+            for (int jj = j_begin; jj < j_end; jj += tile_cols) {
+                const int i_stop = std::min(ii + tile_rows, i_end);
+                const int j_stop = std::min(jj + tile_cols, j_end);
+                for (int i = ii; i < i_stop; ++i) {
+                    for (int j = jj; j < j_stop; ++j) {
+                        body(i, j);
+                    }
+                }
+            }
+        }
+    }
+
+    // One band of consecutive rows per thread, like a static omp parallel for over rows
+    inline Config row_bands(int threads, int rows, int cols) {
+        return {threads, (rows + threads - 1) / threads, cols};
+    }
+
+    // CPU identifier: "model name" from /proc/cpuinfo, or, where that is missing (e.g. on ARM),
+    // the machine type with "Hardware" / "CPU implementer" / "CPU part", or the host name as a last resort
+    inline std::string cpu_model() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line, hardware, implementer, part;
+        auto value = [&line]() {
+            auto pos = line.find(':');
+            return pos != std::string::npos && pos + 2 <= line.size() ? line.substr(pos + 2) : std::string();
+        };
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) == 0) {
+                return value();
+            } else if (line.rfind("Hardware", 0) == 0 && hardware.empty()) {
+                hardware = value();
+            } else if (line.rfind("CPU implementer", 0) == 0 && implementer.empty()) {
+                implementer = value();
+            } else if (line.rfind("CPU part", 0) == 0 && part.empty()) {
+                part = value();
+            }
+        }
+
+        utsname host{};
+        uname(&host);
+        std::string model = host.machine;
+        if (!hardware.empty()) {
+            model += " " + hardware;
+        }
+        if (!implementer.empty() || !part.empty()) {
+            model += " implementer " + implementer + " part " + part;
+        }
+        if (hardware.empty() && implementer.empty() && part.empty()) {
+            model += std::string(" ") + host.nodename;
+        }
+        return model;
+    }
+
+    // Cache location: $SHM_AUTOTUNE_CACHE, else $XDG_CACHE_HOME or ~/.cache
+    inline std::filesystem::path cache_path() {
+        if (const char* path = std::getenv("SHM_AUTOTUNE_CACHE")) {
+            return path;
+        }
+        std::filesystem::path dir;
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+            dir = xdg;
+        } else if (const char* home = std::getenv("HOME")) {
+            dir = std::filesystem::path(home) / ".cache";
+        } else {
+            dir = std::filesystem::temp_directory_path();
+        }
+        return dir / "pycpp_shm_minimal" / "autotune.tsv";
+    }
+
+    // Cache key: kernel name, layout hash, CPU model and hardware thread count, tab separated
+    inline std::string cache_key(const char* kernel) {
+        return std::string(kernel) + '\t' + SHM_LAYOUT_HASH + '\t' + cpu_model()
+               + '\t' + std::to_string(std::thread::hardware_concurrency());
+    }
+
+    // Look up a tuned configuration, falling back to defaults on a cache miss
+    inline Config load(const char* kernel, const Config& defaults) {
+        std::ifstream cache(cache_path());
+        const std::string key = cache_key(kernel) + '\t';
+        std::string line;
+        while (std::getline(cache, line)) {
+            if (line.rfind(key, 0) != 0) {
+                continue;
+            }
+            Config config{};
+            std::istringstream values(line.substr(key.size()));
+            if (values >> config.threads >> config.tile_rows >> config.tile_cols
+                && config.threads > 0 && config.tile_rows > 0 && config.tile_cols > 0) {
+                return config;
+            }
+        }
+        return defaults;
+    }
+
+    // Store a configuration, replacing any previous entry with the same key
+    inline void store(const char* kernel, const Config& config) {
+        const auto path = cache_path();
+        const std::string key = cache_key(kernel) + '\t';
+
+        std::vector<std::string> lines;
+        {
+            std::ifstream cache(path);
+            std::string line;
+            while (std::getline(cache, line)) {
+                if (!line.empty() && line.rfind(key, 0) != 0) {
+                    lines.push_back(line);
+                }
+            }
+        }
+        lines.push_back(key + std::to_string(config.threads) + '\t'
+                        + std::to_string(config.tile_rows) + '\t'
+                        + std::to_string(config.tile_cols));
+
+        std::filesystem::create_directories(path.parent_path());
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::trunc);
+            if (!out) {
+                throw std::runtime_error("Failed to write autotune cache '" + tmp_path.string() + "'");
+            }
+            for (const auto& line : lines) {
+                out << line << '\n';
+            }
+        }
+        std::filesystem::rename(tmp_path, path);
+    }
+
+    // The full extent, plus sizes from smallest upwards in steps of 4x that are below it
+    inline std::vector<int> tile_sizes(int extent, int smallest) {
+        std::vector<int> sizes{extent};
+        for (int size = smallest; size < extent; size *= 4) {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    // Time candidate configurations over a rows x cols iteration space and store the fastest.
+    // Thread count and tile shape are searched jointly: for every thread count the row-band split
+    // and every tile shape with at least one tile per thread are tried.
+    // Each candidate is timed Repeats times and its fastest run counts; the default is kept
+    // unless the winner beats it by Margin, so timing noise is not persisted.
+    // Candidates run on a private copy-on-write view of the segment, so the shared
+    // contents seen by other processes are left untouched.
+    template <typename Step>
+    inline Config tune(const char* kernel, int rows, int cols, const Config& defaults, int steps, Step&& step) {
+        const int warmup_steps = std::max(1, steps / 10);
+
+        auto measure = [&](const Config& config) {
+            SharedMemoryAccess::remap(MAP_PRIVATE);
+            for (int iter = 0; iter < warmup_steps; ++iter) {
+                step(config);
+            }
+            double best_seconds = 0.0;
+            for (int repeat = 0; repeat < Repeats; ++repeat) {
+                auto start_time = std::chrono::high_resolution_clock::now();
+                for (int iter = 0; iter < steps; ++iter) {
+                    step(config);
+                }
+                auto end_time = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+                if (repeat == 0 || elapsed_seconds.count() < best_seconds) {
+                    best_seconds = elapsed_seconds.count();
+                }
+            }
+
+            std::cout << "  threads=" << config.threads
+                      << " tile=" << config.tile_rows << "x" << config.tile_cols
+                      << ": " << best_seconds << " s" << std::endl;
+            return best_seconds;
+        };
+
+        const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> thread_counts;
+        for (int threads = 1; threads < max_threads; threads *= 2) {
+            thread_counts.push_back(threads);
+        }
+        thread_counts.push_back(max_threads);
+
+        std::vector<Config> candidates;
+        for (int threads : thread_counts) {
+            candidates.push_back(row_bands(threads, rows, cols));
+            for (int tile_rows : tile_sizes(rows, 4)) {
+                for (int tile_cols : tile_sizes(cols, 32)) {
+                    const int tiles = ((rows + tile_rows - 1) / tile_rows) * ((cols + tile_cols - 1) / tile_cols);
+                    if (tiles >= threads) {
+                        candidates.push_back({threads, tile_rows, tile_cols});
+                    }
+                }
+            }
+        }
+
+        const double default_time = measure(defaults);
+        Config best = defaults;
+        double best_time = default_time;
+        for (const Config& candidate : candidates) {
+            if (candidate.threads == defaults.threads && candidate.tile_rows == defaults.tile_rows
+                && candidate.tile_cols == defaults.tile_cols) {
+                continue;
+            }
+            double time = measure(candidate);
+            if (time < best_time) {
+                best = candidate;
+                best_time = time;
+            }
+        }
+        if (best_time > default_time * (1.0 - Margin)) {
+            best = defaults;
+        }
+
+        SharedMemoryAccess::remap(MAP_SHARED);
+        store(kernel, best);
+        return best;
+    }
+
+} // namespace Autotune
@@ -34,6 +34,25 @@ namespace SharedMemoryAccess {
         }
     }
 
+    // Function to replace the mapping in place, keeping addr_ (and all field references) valid.
+    // MAP_PRIVATE gives a copy-on-write scratch view of the current segment contents:
+    // writes stay local to this process until the segment is remapped with MAP_SHARED.
+    inline void remap(int flags) {
+        if (addr_ == nullptr) {
+            initialize();
+        }
+        int fd = shm_open(SHM_NAME, O_RDWR, 0666);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open shared memory '" + std::string(SHM_NAME) + "': " + std::strerror(errno));
+        }
+
+        void* addr = mmap(addr_, SHM_SIZE, PROT_READ | PROT_WRITE, flags | MAP_FIXED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            throw std::runtime_error("mmap() failed: " + std::string(std::strerror(errno)));
+        }
+    }
+
     // Concept to check if a type is a valid SharedMemoryLayout::field_info specialization
     template <typename Tag>
     concept ValidTag = requires {typename SharedMemoryLayout::field_info<Tag>::type;};
@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "../src/shared_memory_access.hpp"
+#include "../src/autotune.hpp"
 
 using SharedMemoryAccess::Fields::dt;
 using SharedMemoryAccess::Fields::mass;
@@ -60,32 +61,29 @@ inline void apply_source(ArrayType& field, float value) {
     }
 }
 
-inline void step_wave() {
+inline void step_wave(const Autotune::Config& config) {
     const float omega = TwoPi * oscillator_frequency;
     const float next_source = std::sin(omega * (timestep + dt));
 
-#pragma omp parallel for num_threads(4)
-    for (int i = 1; i < static_cast<int>(Rows) - 1; ++i) {
-        for (int j = 1; j < static_cast<int>(Cols) - 1; ++j) {
-            const float zc = z[i][j];
-            const float m = mass[i][j];
+    Autotune::parallel_for_tiles(config, 1, static_cast<int>(Rows) - 1, 1, static_cast<int>(Cols) - 1, [](int i, int j) {
+        const float zc = z[i][j];
+        const float m = mass[i][j];
 
-            // Infinite mass means a pinned node.
-            if (!std::isfinite(m)) {
-                next[i][j] = zc;
-                continue;
-            }
+        // Infinite mass means a pinned node.
+        if (!std::isfinite(m)) {
+            next[i][j] = zc;
+            return;
+        }
 
-            const float lap =
-                z[i - 1][j] +
-                z[i + 1][j] +
-                z[i][j - 1] +
-                z[i][j + 1] -
-                4.0f * zc;
+        const float lap =
+            z[i - 1][j] +
+            z[i + 1][j] +
+            z[i][j - 1] +
+            z[i][j + 1] -
+            4.0f * zc;
 
-            next[i][j] = 2.0f * zc - z_prev[i][j] + spring_k * dt * dt * lap / m;
-        }
-    }
+        next[i][j] = 2.0f * zc - z_prev[i][j] + spring_k * dt * dt * lap / m;
+    });
 
     apply_source(next, next_source);
     apply_absorbing_boundaries();
@@ -93,24 +91,42 @@ inline void step_wave() {
     std::memcpy(z, next, sizeof(z));
 }
 
+inline void step(const Autotune::Config& config) {
+    step_wave(config);
+    timestep = timestep + dt;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    const bool autotune = argc >= 2 && std::strcmp(argv[1], "--autotune") == 0;
+    if (argc != 2 && !(autotune && argc == 3)) {
         std::cerr << "Usage: " << argv[0] << " <number of iterations>" << std::endl;
+        std::cerr << "       " << argv[0] << " --autotune [steps per candidate]" << std::endl;
         return 1;
     }
 
-    const int iterations = std::atoi(argv[1]);
+    const int iterations = autotune ? (argc == 3 ? std::atoi(argv[2]) : Autotune::DefaultSteps) : std::atoi(argv[1]);
     if (iterations <= 0) {
         std::cerr << "Number of iterations must be a positive integer." << std::endl;
         return 1;
     }
 
     try {
+        // Default: 4 threads, one band of interior rows each
+        const Autotune::Config defaults = Autotune::row_bands(4, Rows - 2, Cols - 2);
+
+        if (autotune) {
+            const auto config = Autotune::tune("wave", Rows - 2, Cols - 2, defaults, iterations, step);
+            std::cout << "Tuned: threads=" << config.threads
+                      << " tile=" << config.tile_rows << "x" << config.tile_cols << std::endl;
+            return 0;
+        }
+
+        const Autotune::Config config = Autotune::load("wave", defaults);
+
         auto start_time = std::chrono::high_resolution_clock::now();
 
         for (int iter = 0; iter < iterations; ++iter) {
-            step_wave();
-            timestep = timestep + dt;
+            step(config);
         }
 
         auto end_time = std::chrono::high_resolution_clock::now();